@@ -0,0 +1,64 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "common.hpp"
+#include "player.hpp"
+#include "board.hpp"
+
+// Prints the best few moves for a position, each with its score and principal
+// variation. The board is 64 characters, one per square in the order
+// setBoard uses, with 'b' for black, 'w' for white and anything else empty.
+static void usage(const char *name) {
+    fprintf(stderr, "usage: %s [-k lines] [-d depth] [-t seconds] [-c config] board side\n", name);
+    exit(-1);
+}
+
+int main(int argc, char *argv[]) {
+    int lines = 4, depth = 8;
+    double seconds = 10;
+    const char *config = nullptr;
+
+    int i = 1;
+    for (; i + 1 < argc && argv[i][0] == '-'; i += 2) {
+        if (!strcmp(argv[i], "-k")) lines = atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "-d")) depth = atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "-t")) seconds = atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "-c")) config = argv[i + 1];
+        else usage(argv[0]);
+    }
+    if (argc - i != 2 || strlen(argv[i]) != 64) usage(argv[0]);
+
+    char boardData[64];
+    memcpy(boardData, argv[i], 64);
+    Board *board = new Board();
+    board->setBoard(boardData);
+    Side side = (!strcmp(argv[i + 1], "Black")) ? BLACK : WHITE;
+
+    Player *player = new Player(side, ALPHA_BETA, false);
+    if (config != nullptr && !player->loadConfig(config)) {
+        fprintf(stderr, "can't read config %s\n", config);
+        exit(-1);
+    }
+    player->multi_pv = lines > 0 ? lines : 1;
+    player->take_corners = false;
+
+    Move *move = player->search(board, side, depth, (int) (seconds * 1000));
+    if (move == nullptr) {
+        printf("%s has to pass\n", player->print_side(side));
+        return 0;
+    }
+    delete move;
+
+    printf("depth %d\n", player->search_depth);
+    for (unsigned int j = 0; j < player->lines.size(); j++) {
+        printf("%2u. score %4d  pv:", j + 1, player->lines[j].score);
+        for (unsigned int k = 0; k < player->lines[j].pv.size(); k++) {
+            printf(" %d,%d", player->lines[j].pv[k].getX(), player->lines[j].pv[k].getY());
+        }
+        printf("\n");
+    }
+
+    delete player;
+    delete board;
+    return 0;
+}
@@ -167,6 +167,22 @@ bool Board::checkSquare(Side side, int x, int y)
     return this->get(side, x, y);
 }
 
+/*
+ * Returns a 64-bit key for this position with the given side to move, for
+ * looking it up in the transposition table.
+ */
+unsigned long long Board::hash(Side side) {
+    unsigned long long key = black.to_ullong() * 0x9E3779B97F4A7C15ULL;
+    key ^= taken.to_ullong() + 0x632BE59BD9B4E019ULL + (key << 6) + (key >> 2);
+    // finish with the splitmix64 mixer so nearby boards spread out
+    key ^= key >> 30;
+    key *= 0xBF58476D1CE4E5B9ULL;
+    key ^= key >> 27;
+    key *= 0x94D049BB133111EBULL;
+    key ^= key >> 31;
+    return side == BLACK ? key : ~key;
+}
+
 /*
  * Sets the board state given an 8x8 char array where 'w' indicates a white
  * piece and 'b' indicates a black piece. Mainly for testing purposes.
@@ -183,3 +199,13 @@ void Board::setBoard(char data[]) {
         }
     }
 }
+
+/*
+ * Sets the board state from a pair of 64-bit masks, one per color, where bit
+ * x + 8*y is set if that color occupies square (x, y). The masks must not
+ * overlap.
+ */
+void Board::setBitboards(unsigned long long blackBits, unsigned long long whiteBits) {
+    black = bitset<64>(blackBits);
+    taken = bitset<64>(blackBits | whiteBits);
+}
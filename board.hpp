@@ -29,8 +29,10 @@ public:
     int countBlack();
     int countWhite();
     bool checkSquare(Side side, int x, int y);
+    unsigned long long hash(Side side);
 
     void setBoard(char data[]);
+    void setBitboards(unsigned long long blackBits, unsigned long long whiteBits);
 };
 
 #endif
@@ -0,0 +1,31 @@
+#include "control.hpp"
+
+SearchControl::SearchControl() : check_nodes(256), search(1), stop_search(0) {
+    has_deadline = false;
+    deadline = std::chrono::steady_clock::now();
+    countdown = 0;
+}
+
+void SearchControl::start(int ms) {
+    has_deadline = ms > 0;
+    deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(ms);
+    countdown = check_nodes;
+    search.fetch_add(1);
+}
+
+void SearchControl::stop() {
+    stop_search.store(search.load());
+}
+
+bool SearchControl::poll() {
+    if (--countdown > 0) return stopped();
+    countdown = check_nodes;
+    return check();
+}
+
+bool SearchControl::check() {
+    if (has_deadline && !stopped() && std::chrono::steady_clock::now() >= deadline) {
+        stop();
+    }
+    return stopped();
+}
@@ -0,0 +1,47 @@
+#ifndef __CONTROL_H__
+#define __CONTROL_H__
+
+#include <atomic>
+#include <chrono>
+
+/*
+ * Decides when a search has to stop: either its time budget ran out or
+ * another thread called stop(). The clock is a monotonic one and is only read
+ * every check_nodes calls to poll(), so the per-node cost is a counter and a
+ * flag load.
+ *
+ * Every start() begins a new numbered search and stop() marks the one that is
+ * current when it is called, so a stop that comes in after a search is over
+ * can't cut the next one short.
+ */
+class SearchControl {
+
+public:
+    SearchControl();
+
+    // arm for a new search; a budget of 0 or less means no time limit
+    void start(int ms);
+    // asks the running search to stop; safe to call from any thread
+    void stop();
+
+    bool stopped() {
+        return stop_search.load(std::memory_order_relaxed) == search.load(std::memory_order_relaxed);
+    }
+    // once per node from the searching thread
+    bool poll();
+    // reads the clock; safe to call from any thread
+    bool check();
+
+    // nodes between clock reads
+    int check_nodes;
+
+private:
+    // number of the current search, and of the last one told to stop
+    std::atomic<unsigned long> search;
+    std::atomic<unsigned long> stop_search;
+    bool has_deadline;
+    std::chrono::steady_clock::time_point deadline;
+    int countdown;
+};
+
+#endif
@@ -0,0 +1,225 @@
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "logger.hpp"
+
+// number of records the ring holds, a power of two
+static const size_t LOG_CAPACITY = 1024;
+
+// longest the writer sleeps with the ring empty; producers normally wake it
+// sooner, this only covers a wakeup sent just before it started waiting
+static const int LOG_IDLE_MS = 1000;
+
+/*
+ * Bounded multi-producer ring in the style of Vyukov's queue: every slot
+ * carries a sequence number saying whether it is free for the producer at
+ * that position or holds a record for the consumer.
+ */
+class Logger {
+
+public:
+    Logger();
+    ~Logger();
+
+    bool push(const LogRecord& record);
+
+private:
+    struct Slot {
+        std::atomic<size_t> seq;
+        LogRecord record;
+    };
+
+    Slot slots[LOG_CAPACITY];
+    std::atomic<size_t> enqueue_pos;
+    size_t dequeue_pos;
+    std::atomic<long> dropped;
+    std::atomic<bool> running;
+    std::thread writer;
+
+    // set by the writer before it waits, so producers only notify when
+    // there is someone to wake
+    std::atomic<bool> sleeping;
+    std::mutex lock;
+    std::condition_variable wake;
+
+    bool empty();
+    bool pop(LogRecord *record);
+    void run();
+};
+
+/*
+ * Expands one record's format with its stored arguments, printf style.
+ */
+static void format_record(const LogRecord& record, std::string *out) {
+    if (record.level == LOG_LEVEL_ERROR) *out += "error: ";
+    else if (record.level == LOG_LEVEL_WARN) *out += "warning: ";
+
+    int arg = 0;
+    for (const char *p = record.format; *p; p++) {
+        if (*p != '%') {
+            *out += *p;
+            continue;
+        }
+        if (p[1] == '%') {
+            *out += '%';
+            p++;
+            continue;
+        }
+
+        // keep flags, width and precision; the length comes from the stored type
+        char spec[32] = "%";
+        size_t n = 1;
+        p++;
+        while (*p && strchr("-+ #0123456789.", *p) && n < sizeof(spec) - 4) spec[n++] = *p++;
+        while (*p && strchr("hlLqjzt", *p)) p++;
+        if (!*p) break;
+        if (arg >= record.nargs) {
+            *out += '?';
+            continue;
+        }
+
+        char buf[128];
+        bool integer = strchr("diouxX", *p) != nullptr;
+        char real = strchr("eEfFgGaA", *p) != nullptr ? *p : 'g';
+        switch (record.types[arg]) {
+        case LOG_INT:
+            if (integer) {
+                spec[n++] = 'l';
+                spec[n++] = 'l';
+                spec[n++] = *p;
+                spec[n] = '\0';
+                snprintf(buf, sizeof(buf), spec, record.values[arg].i);
+            } else {
+                spec[n++] = real;
+                spec[n] = '\0';
+                snprintf(buf, sizeof(buf), spec, (double) record.values[arg].i);
+            }
+            break;
+        case LOG_DOUBLE:
+            if (integer) {
+                strcpy(spec + n, "lld");
+                snprintf(buf, sizeof(buf), spec, (long long) record.values[arg].d);
+            } else {
+                spec[n++] = real;
+                spec[n] = '\0';
+                snprintf(buf, sizeof(buf), spec, record.values[arg].d);
+            }
+            break;
+        default:
+            spec[n++] = 's';
+            spec[n] = '\0';
+            snprintf(buf, sizeof(buf), spec, record.values[arg].s != nullptr ? record.values[arg].s : "(null)");
+            break;
+        }
+        *out += buf;
+        arg++;
+    }
+}
+
+Logger::Logger() : enqueue_pos(0), dequeue_pos(0), dropped(0), running(true), sleeping(false) {
+    for (size_t i = 0; i < LOG_CAPACITY; i++) {
+        slots[i].seq.store(i, std::memory_order_relaxed);
+    }
+    writer = std::thread(&Logger::run, this);
+}
+
+/*
+ * Writes out whatever is still queued before the program exits.
+ */
+Logger::~Logger() {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        running.store(false);
+        sleeping.store(false);
+    }
+    wake.notify_one();
+    writer.join();
+}
+
+bool Logger::push(const LogRecord& record) {
+    size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+    Slot *slot;
+    while (true) {
+        slot = &slots[pos & (LOG_CAPACITY - 1)];
+        size_t seq = slot->seq.load(std::memory_order_acquire);
+        long diff = (long) seq - (long) pos;
+        if (diff == 0) {
+            if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            // the writer hasn't caught up; drop rather than wait for it
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            pos = enqueue_pos.load(std::memory_order_relaxed);
+        }
+    }
+    slot->record = record;
+    slot->seq.store(pos + 1, std::memory_order_release);
+
+    // pairs with the fence in run so either the writer sees this record or
+    // we see it asleep
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping.load(std::memory_order_relaxed) && sleeping.exchange(false)) {
+        wake.notify_one();
+    }
+    return true;
+}
+
+bool Logger::empty() {
+    Slot *slot = &slots[dequeue_pos & (LOG_CAPACITY - 1)];
+    return slot->seq.load(std::memory_order_acquire) != dequeue_pos + 1;
+}
+
+bool Logger::pop(LogRecord *record) {
+    Slot *slot = &slots[dequeue_pos & (LOG_CAPACITY - 1)];
+    if (slot->seq.load(std::memory_order_acquire) != dequeue_pos + 1) return false;
+    *record = slot->record;
+    slot->seq.store(dequeue_pos + LOG_CAPACITY, std::memory_order_release);
+    dequeue_pos++;
+    return true;
+}
+
+void Logger::run() {
+    std::string text;
+    LogRecord record;
+    while (true) {
+        bool stopping = !running.load();
+        text.clear();
+        while (pop(&record)) {
+            format_record(record, &text);
+        }
+        long lost = dropped.exchange(0, std::memory_order_relaxed);
+        if (lost > 0) {
+            char buf[64];
+            snprintf(buf, sizeof(buf), "(%ld log messages dropped)\n", lost);
+            text += buf;
+        }
+
+        if (!text.empty()) {
+            fwrite(text.data(), 1, text.size(), stderr);
+            fflush(stderr);
+        } else if (stopping) {
+            break;
+        } else {
+            std::unique_lock<std::mutex> guard(lock);
+            sleeping.store(true);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (empty() && running.load()) {
+                wake.wait_for(guard, std::chrono::milliseconds(LOG_IDLE_MS),
+                              [this] { return !sleeping.load(); });
+            }
+            sleeping.store(false);
+        }
+    }
+}
+
+bool log_push(const LogRecord& record) {
+    // started on first use and drained when the program exits
+    static Logger logger;
+    return logger.push(record);
+}
@@ -0,0 +1,108 @@
+#ifndef __LOGGER_H__
+#define __LOGGER_H__
+
+/*
+ * Asynchronous logging. The LOG_* macros copy the format string pointer and
+ * up to LOG_MAX_ARGS arguments into a fixed-size record and push it onto a
+ * lock-free ring buffer; a background thread does the formatting and writes
+ * to stderr. If the ring is full the message is dropped rather than making
+ * the search wait.
+ *
+ * Formats must be string literals, and so must any %s arguments, since they
+ * are only read once the record gets written out.
+ *
+ * Messages above SHARKNADO_LOG_LEVEL are compiled out; build with
+ * -DSHARKNADO_LOG_LEVEL=0 for no logging at all.
+ */
+
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN  2
+#define LOG_LEVEL_INFO  3
+#define LOG_LEVEL_DEBUG 4
+
+#ifndef SHARKNADO_LOG_LEVEL
+#define SHARKNADO_LOG_LEVEL LOG_LEVEL_DEBUG
+#endif
+
+#define LOG_MAX_ARGS 6
+
+enum LogType {
+    LOG_INT, LOG_DOUBLE, LOG_STRING
+};
+
+union LogValue {
+    long long i;
+    double d;
+    const char *s;
+};
+
+struct LogRecord {
+    const char *format;
+    unsigned char level;
+    unsigned char nargs;
+    unsigned char types[LOG_MAX_ARGS];
+    LogValue values[LOG_MAX_ARGS];
+};
+
+// queues a record for the writer thread; returns false if it was dropped
+bool log_push(const LogRecord& record);
+
+inline void log_set(LogRecord& record, int i, long long value) {
+    record.types[i] = LOG_INT;
+    record.values[i].i = value;
+}
+
+inline void log_set(LogRecord& record, int i, int value) { log_set(record, i, (long long) value); }
+inline void log_set(LogRecord& record, int i, unsigned int value) { log_set(record, i, (long long) value); }
+inline void log_set(LogRecord& record, int i, long value) { log_set(record, i, (long long) value); }
+inline void log_set(LogRecord& record, int i, unsigned long value) { log_set(record, i, (long long) value); }
+
+inline void log_set(LogRecord& record, int i, double value) {
+    record.types[i] = LOG_DOUBLE;
+    record.values[i].d = value;
+}
+
+inline void log_set(LogRecord& record, int i, const char *value) {
+    record.types[i] = LOG_STRING;
+    record.values[i].s = value;
+}
+
+template <typename... Args>
+void log_write(int level, const char *format, Args... args) {
+    static_assert(sizeof...(Args) <= LOG_MAX_ARGS, "too many arguments to log");
+    LogRecord record;
+    record.format = format;
+    record.level = level;
+    record.nargs = sizeof...(Args);
+    int i = 0;
+    int unused[] = { 0, (log_set(record, i++, args), 0)... };
+    (void) unused;
+    (void) i;
+    log_push(record);
+}
+
+#if SHARKNADO_LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(...) log_write(LOG_LEVEL_ERROR, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) do {} while (0)
+#endif
+
+#if SHARKNADO_LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_WARN(...) log_write(LOG_LEVEL_WARN, __VA_ARGS__)
+#else
+#define LOG_WARN(...) do {} while (0)
+#endif
+
+#if SHARKNADO_LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(...) log_write(LOG_LEVEL_INFO, __VA_ARGS__)
+#else
+#define LOG_INFO(...) do {} while (0)
+#endif
+
+#if SHARKNADO_LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...) log_write(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) do {} while (0)
+#endif
+
+#endif
@@ -0,0 +1,287 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include "mcts.hpp"
+#include "player.hpp"
+
+// expansion state of a node; only the thread that moves a node from
+// UNEXPANDED to EXPANDING gets to create its children
+static const int UNEXPANDED = 0;
+static const int EXPANDING = 1;
+static const int EXPANDED = 2;
+
+// playout result when neither side wins
+static const int DRAW = -1;
+
+static Side other(Side side) { return side == WHITE ? BLACK : WHITE; }
+
+static void play(Board *board, int move, Side side) {
+    if (move < 0) return;
+    Move m(move % 8, move / 8);
+    board->doMove(&m, side);
+}
+
+MCTS::MCTS(Player *player, int threads) {
+    this->player = player;
+    this->threads = threads > 0 ? threads : 1;
+    exploration = 1.4;
+    virtual_loss = 3;
+    playout_depth = 0;
+    playout_greedy = 0;
+
+    playouts = 0;
+    playouts_per_sec = 0;
+    win_rate = 0;
+    depth = 0;
+
+    pool_size = 1 << 20;
+    pool = new MCTSNode[pool_size];
+    pool_next = 0;
+    max_depth = 0;
+}
+
+MCTS::~MCTS() {
+    delete[] pool;
+}
+
+/*
+ * Hands out count consecutive nodes from the pool, or nullptr once the pool
+ * is used up.
+ */
+MCTSNode *MCTS::allocate(int count) {
+    size_t first = pool_next.fetch_add(count);
+    if (first + count > pool_size) return nullptr;
+    return &pool[first];
+}
+
+void MCTS::init(MCTSNode *node, MCTSNode *parent, int move, Side side) {
+    node->parent = parent;
+    node->children = nullptr;
+    node->num_children = 0;
+    node->move = move;
+    node->side = side;
+    node->visits.store(0);
+    node->wins.store(0);
+    node->state.store(UNEXPANDED);
+}
+
+/*
+ * Creates the children of a node the caller has marked EXPANDING. A side with
+ * no moves gets a single pass child unless the game is over, in which case the
+ * node is left without children. If the pool is full the node stays a leaf.
+ */
+void MCTS::expand(MCTSNode *node, Board *board) {
+    Side to_move = other(node->side);
+    std::vector<Move> moves = player->valid_moves(board, to_move, false);
+    int count = moves.size();
+    if (count == 0 && !board->hasMoves(node->side)) {
+        node->state.store(EXPANDED, std::memory_order_release);
+        return;
+    }
+
+    MCTSNode *children = allocate(count > 0 ? count : 1);
+    if (children == nullptr) {
+        node->state.store(UNEXPANDED, std::memory_order_release);
+        return;
+    }
+    if (count == 0) {
+        init(&children[0], node, -1, to_move);
+        count = 1;
+    }
+    for (unsigned int i = 0; i < moves.size(); i++) {
+        init(&children[i], node, moves[i].getX() + 8 * moves[i].getY(), to_move);
+    }
+    node->children = children;
+    node->num_children = count;
+    node->state.store(EXPANDED, std::memory_order_release);
+}
+
+/*
+ * Picks the child with the best UCB1 value, trying unvisited children first.
+ */
+MCTSNode *MCTS::select(MCTSNode *node) {
+    double log_visits = log((double) node->visits.load() + 1);
+    MCTSNode *best = &node->children[0];
+    double best_value = -1;
+    for (int i = 0; i < node->num_children; i++) {
+        MCTSNode *child = &node->children[i];
+        int visits = child->visits.load();
+        if (visits == 0) return child;
+        double value = child->wins.load() / (2.0 * visits)
+                     + exploration * sqrt(log_visits / visits);
+        if (value > best_value) {
+            best = child;
+            best_value = value;
+        }
+    }
+    return best;
+}
+
+/*
+ * Returns the index of the move after which getScore rates the position best
+ * for the side making it.
+ */
+int MCTS::greedy_move(Board *board, Side to_move, std::vector<Move>& moves) {
+    int best = 0;
+    int best_score = 0;
+    for (unsigned int i = 0; i < moves.size(); i++) {
+        Board next_board = *board;
+        next_board.doMove(&moves[i], to_move);
+        int score = player->getScore(&next_board, to_move);
+        if (i == 0 || score > best_score) {
+            best = i;
+            best_score = score;
+        }
+    }
+    return best;
+}
+
+/*
+ * Plays moves from the given position and returns the winning side, or DRAW.
+ * Moves are random except for the playout_greedy share picked by getScore.
+ * Playouts cut off by playout_depth are decided by getScore.
+ */
+int MCTS::playout(Board *board, Side to_move, std::mt19937& rng) {
+    std::uniform_real_distribution<double> coin(0, 1);
+    bool passed = false;
+    bool done = false;
+    for (int plies = 0; playout_depth == 0 || plies < playout_depth; plies++) {
+        std::vector<Move> moves = player->valid_moves(board, to_move, false);
+        if (moves.size() == 0) {
+            // neither side can move
+            if (passed) {
+                done = true;
+                break;
+            }
+            passed = true;
+        } else {
+            passed = false;
+            int choice;
+            if (playout_greedy > 0 && coin(rng) < playout_greedy) {
+                choice = greedy_move(board, to_move, moves);
+            } else {
+                std::uniform_int_distribution<int> pick(0, moves.size() - 1);
+                choice = pick(rng);
+            }
+            board->doMove(&moves[choice], to_move);
+        }
+        to_move = other(to_move);
+    }
+
+    if (!done) {
+        int score = player->getScore(board, to_move);
+        if (score == 0) return DRAW;
+        return score > 0 ? to_move : other(to_move);
+    }
+    int black = board->countBlack();
+    int white = board->countWhite();
+    if (black == white) return DRAW;
+    return black > white ? BLACK : WHITE;
+}
+
+/*
+ * Runs select / expand / playout / backpropagate until the turn is over.
+ */
+void MCTS::worker(MCTSNode *root, Board *board, SearchControl *control, unsigned int seed, std::atomic<long> *count) {
+    std::mt19937 rng(seed);
+    while (!control->check()) {
+        Board next_board = *board;
+        MCTSNode *node = root;
+        int d = 0;
+        node->visits.fetch_add(virtual_loss);
+
+        while (true) {
+            int state = node->state.load(std::memory_order_acquire);
+            if (state == UNEXPANDED) {
+                int expected = UNEXPANDED;
+                if (node->state.compare_exchange_strong(expected, EXPANDING)) {
+                    expand(node, &next_board);
+                    state = node->state.load(std::memory_order_acquire);
+                }
+            }
+            if (state != EXPANDED || node->num_children == 0) break;
+
+            node = select(node);
+            int visits = node->visits.fetch_add(virtual_loss);
+            play(&next_board, node->move, node->side);
+            d++;
+            // a node gets one playout of its own before it is expanded
+            if (visits == 0) break;
+        }
+
+        int winner = playout(&next_board, other(node->side), rng);
+        for (MCTSNode *n = node; n != nullptr; n = n->parent) {
+            n->wins.fetch_add(winner == DRAW ? 1 : (winner == n->side ? 2 : 0));
+            n->visits.fetch_sub(virtual_loss - 1);
+        }
+
+        int deepest = max_depth.load();
+        while (d > deepest && !max_depth.compare_exchange_weak(deepest, d)) {}
+        count->fetch_add(1);
+    }
+}
+
+/*
+ *  @brief picks the most visited move after searching until control says
+ *  to stop
+ *
+ *  @arguments:
+ *  board state, side to move, time limit and stop flag; returns nullptr if side
+ *  has to pass and fills in the stats of the search
+ *
+ */
+Move *MCTS::search(Board *board, Side side, SearchControl *control) {
+    pool_next = 0;
+    max_depth = 0;
+    playouts = 0;
+    playouts_per_sec = 0;
+    win_rate = 0;
+    pv.clear();
+
+    Board root_board = *board;
+    MCTSNode *root = allocate(1);
+    init(root, nullptr, -1, other(side));
+    root->state.store(EXPANDING);
+    expand(root, &root_board);
+    if (root->num_children == 0 || root->children[0].move < 0) {
+        depth = 0;
+        return nullptr;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::atomic<long> count(0);
+    std::random_device seed;
+    std::vector<std::thread> workers;
+    for (int i = 1; i < threads; i++) {
+        workers.push_back(std::thread(&MCTS::worker, this, root, &root_board, control, seed(), &count));
+    }
+    worker(root, &root_board, control, seed(), &count);
+    for (unsigned int i = 0; i < workers.size(); i++) {
+        workers[i].join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    // follow the most visited children for the principal variation
+    MCTSNode *best = nullptr;
+    for (MCTSNode *node = root; node->state.load() == EXPANDED && node->num_children > 0; ) {
+        MCTSNode *next = &node->children[0];
+        for (int i = 1; i < node->num_children; i++) {
+            if (node->children[i].visits.load() > next->visits.load()) next = &node->children[i];
+        }
+        if (next->move < 0 || next->visits.load() == 0) break;
+        if (best == nullptr) best = next;
+        pv.push_back(Move(next->move % 8, next->move / 8));
+        node = next;
+    }
+    if (best == nullptr) best = &root->children[0];
+
+    playouts = count.load();
+    playouts_per_sec = elapsed.count() > 0 ? playouts / elapsed.count() : 0;
+    if (best->visits.load() > 0) win_rate = best->wins.load() / (2.0 * best->visits.load());
+    depth = max_depth.load();
+
+    Move *final_move = new Move(best->move % 8, best->move / 8);
+    final_move->score = (int) (200 * win_rate) - 100;
+    return final_move;
+}
@@ -0,0 +1,76 @@
+#ifndef __MCTS_H__
+#define __MCTS_H__
+
+#include <atomic>
+#include <random>
+#include <vector>
+#include "common.hpp"
+#include "board.hpp"
+#include "control.hpp"
+
+class Player;
+
+// one node of the search tree, standing for the position after `move`
+struct MCTSNode {
+    MCTSNode *parent;
+    MCTSNode *children;
+    int num_children;
+    // square x + 8*y of the move leading here, -1 for a pass
+    int move;
+    // side that made that move
+    Side side;
+    // visits include virtual losses of playouts still in flight
+    std::atomic<int> visits;
+    // results for side, in half points (2 per win, 1 per draw)
+    std::atomic<int> wins;
+    std::atomic<int> state;
+};
+
+class MCTS {
+
+public:
+    MCTS(Player *player, int threads);
+    ~MCTS();
+
+    Move *search(Board *board, Side side, SearchControl *control);
+
+    // -------------- tunable parameters ------------------- //
+    int threads;
+    // UCB1 exploration constant
+    double exploration;
+    // visits added to a node while a playout through it is in flight
+    int virtual_loss;
+    // cut playouts off after this many plies and score them with getScore;
+    // 0 plays every game out to the end
+    int playout_depth;
+    // chance that a playout move is the one getScore likes best for the
+    // side making it instead of a random one; 0 keeps playouts uniform
+    double playout_greedy;
+
+    // -------------- stats of the last search ------------- //
+    long playouts;
+    double playouts_per_sec;
+    // win rate of the chosen move for the side to move
+    double win_rate;
+    int depth;
+    std::vector<Move> pv;
+
+private:
+    Player *player;
+
+    // nodes are handed out from a fixed pool that is reset every search
+    MCTSNode *pool;
+    size_t pool_size;
+    std::atomic<size_t> pool_next;
+    std::atomic<int> max_depth;
+
+    MCTSNode *allocate(int count);
+    void init(MCTSNode *node, MCTSNode *parent, int move, Side side);
+    void expand(MCTSNode *node, Board *board);
+    MCTSNode *select(MCTSNode *node);
+    int greedy_move(Board *board, Side to_move, std::vector<Move>& moves);
+    int playout(Board *board, Side to_move, std::mt19937& rng);
+    void worker(MCTSNode *root, Board *board, SearchControl *control, unsigned int seed, std::atomic<long> *count);
+};
+
+#endif
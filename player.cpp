@@ -1,13 +1,37 @@
+#include <cstdio>
+#include <cstring>
+#include <thread>
 #include "player.hpp"
+#include "logger.hpp"
+
+// bound for a full window; far above anything getScore can return with any
+// weights in a config file, and still small enough for TTEntry's short score
+static const int INF = 30000;
+
+// transposition table size until the library asks for another one
+static const int DEFAULT_HASH_MB = 16;
 
 /*
  * Constructor for the player; initialize everything here. The color your AI is
  * on (BLACK or WHITE) is passed in as "color". The constructor must finish
  * within 30 seconds.
  */
-Player::Player(Side color) {
+Player::Player(Side color, SearchMode mode, bool verbose) : tt(DEFAULT_HASH_MB) {
     // Will be set to true in test_minimax.cpp.
     minimaxTest = false;
+    this->verbose = verbose;
+    search_depth = 0;
+    nodes = 0;
+    extensions = 0;
+    multi_pv = 1;
+    take_corners = true;
+
+    // the tree search uses every core by default
+    this->mode = mode;
+    mcts = nullptr;
+    if (mode == MONTE_CARLO) {
+        mcts = new MCTS(this, std::thread::hardware_concurrency());
+    }
 
     // initialize board and side
     board = new Board();
@@ -21,13 +45,14 @@ Player::Player(Side color) {
             adjacents.push_back(adjacent);
         }
     }
-    fprintf(stderr, "Sharknado is on color %s!\n", print_side(side));
+    if (verbose) LOG_INFO("Sharknado is on color %s!\n", print_side(side));
 }
 
 /*
  * Destructor for the player.
  */
 Player::~Player() {
+    delete mcts;
 }
 
 
@@ -46,37 +71,104 @@ Player::~Player() {
  * return nullptr.
  */
 Move *Player::doMove(Move *opponentsMove, int msLeft) {
-     time_t end_turn = time(nullptr) + (time_t) (300. / (64 / 2));
-     time_t now;
+     int turn_ms = 300000 / (64 / 2);
     // --------------- update opponent's move ----------------- //
     Side opp_side = side == WHITE ? BLACK : WHITE;
     if (opponentsMove != nullptr){
         board->doMove(opponentsMove, opp_side);
-        fprintf(stderr, "-----------------------------------\n%s's move: %d %d\n",
+        LOG_INFO("-----------------------------------\n%s's move: %d %d\n",
                 print_side(opp_side), opponentsMove->getX(), opponentsMove->getY());
     } else {
-        fprintf(stderr, "-----------------------------------\n%s has no valid moves~\n", print_side(opp_side));
+        LOG_INFO("-----------------------------------\n%s has no valid moves~\n", print_side(opp_side));
     }
 
     // display current score
-    fprintf(stderr, "prev score: %s: %d to %s: %d\n", print_side(side),
+    LOG_INFO("prev score: %s: %d to %s: %d\n", print_side(side),
             board->count(side), print_side(opp_side), board->count(opp_side));
 
     //--------------find moves and choose one------------------//
 
+    // iterative deepening to max depth 11, or tree search until time is up
+    Move *best_move = this->search(board, side, 11, turn_ms);
+
+    // display new move, if it's not pass, add it to past moves
+    if (best_move != nullptr){
+        LOG_INFO("%s's move: %d %d\n",
+                print_side(side), best_move->getX(), best_move->getY());
+    } else {
+        LOG_INFO("%s has to pass!\n",
+                print_side(side));
+    }
+
+    //------------- update board with chosen move! ----------------//
+    board->doMove(best_move, side);
+    LOG_INFO("new  score:  %s: %d to %s: %d\n-----------------------------------\n",
+            print_side(side), board->count(side), print_side(opp_side), board->count(opp_side));
+    return best_move;
+}
+
+/*
+ * @brief iterative deepening search from the given position
+ *
+ *  @in board state to search, side to move, deepest ply to try, and the time
+ *  budget in milliseconds (0 for none); returns the best move of the deepest completed
+ *  iteration (nullptr only if side has to pass), since an iteration cut short by
+ *  the clock or by stop() is thrown away, and leaves its principal variation
+ *  in pv, its multi_pv best lines in lines and its depth in search_depth; if
+ *  not even the first iteration finishes it returns the first legal move with
+ *  the static score and a search_depth of 0
+ *
+ *  in MONTE_CARLO mode the tree search runs until it is stopped instead, and
+ *  max_plys is ignored
+ *
+ */
+Move *Player::search(Board *board, Side side, int max_plys, int ms)
+{
+    control.start(ms);
+    if (mode == MONTE_CARLO)
+    {
+        Move *best_move = mcts->search(board, side, &control);
+        pv = mcts->pv;
+        lines.clear();
+        if (best_move != nullptr)
+        {
+            // no playout may have finished, leaving the tree without a line
+            if (pv.empty()) pv.push_back(*best_move);
+            // the tree search only reports its best line
+            PVLine best = { best_move->score, pv };
+            lines.push_back(best);
+        }
+        search_depth = mcts->depth;
+        if (verbose) LOG_INFO("%ld playouts (%.0f/s), depth %d, win rate %.3f\n",
+            mcts->playouts, mcts->playouts_per_sec, mcts->depth, mcts->win_rate);
+        return best_move;
+    }
+
     std::vector<Move> valid_moves = this->valid_moves(board, side, false);
     std::list<Move> ordered_moves;
-    Move *best_move = new Move(0,0);
-    best_move = nullptr;
+    std::vector<PVLine> ranked;
+    Move *best_move = nullptr;
     int plys = 1;
-    bool timeout = false;
-
-    // iterative deepening to max depth 8
+    pv.clear();
+    lines.clear();
+    search_depth = 0;
+    nodes = 0;
+    extensions = 0;
+
+    // something legal to play if the first iteration gets cut short
+    if (!valid_moves.empty())
+    {
+        best_move = new Move(valid_moves[0]);
+        best_move->score = getScore(board, side);
+        PVLine first = { best_move->score, std::vector<Move>(1, valid_moves[0]) };
+        lines.push_back(first);
+        pv = first.pv;
+    }
 
-    while (difftime(end_turn, time(&now)) > 0 && plys < 12)
+    while (!control.check() && plys <= max_plys)
     {
         // orders the valid_moves vector by bestness of move after 2-ply search
-        if (plys == 3)
+        if (plys == 3 && ordered_moves.size() == valid_moves.size())
         {
             for (unsigned int i = 0; i < valid_moves.size(); i++)
             {
@@ -84,28 +176,39 @@ Move *Player::doMove(Move *opponentsMove, int msLeft) {
                 ordered_moves.pop_front();
             }
         }
-        Move *temp_move = this->choose_move(board, side, valid_moves, ordered_moves, plys, end_turn, timeout);
-        if (!timeout)
+        Move *temp_move = this->choose_move(board, side, valid_moves, ordered_moves, plys, &ranked);
+        if (control.stopped())
         {
-            best_move = temp_move;
-            fprintf(stderr, "ply: %d, best move: %d %d\n",
-                plys, best_move->getX(), best_move->getY());
+            delete temp_move;
+            break;
+        }
+        delete best_move;
+        best_move = temp_move;
+        lines = ranked;
+        pv.clear();
+        if (!lines.empty()) pv = lines[0].pv;
+        search_depth = plys;
+        // nothing to deepen if we have to pass
+        if (best_move == nullptr) break;
+        if (verbose) LOG_DEBUG("ply: %d, best move: %d %d, %ld nodes\n",
+            plys, best_move->getX(), best_move->getY(), nodes);
+
+        // search the best lines first next time so the window closes early
+        for (unsigned int i = lines.size(); i-- > 0; )
+        {
+            for (unsigned int j = 0; j < valid_moves.size(); j++)
+            {
+                if (valid_moves[j].getX() == lines[i].pv[0].getX() &&
+                    valid_moves[j].getY() == lines[i].pv[0].getY())
+                {
+                    valid_moves.insert(valid_moves.begin(), valid_moves[j]);
+                    valid_moves.erase(valid_moves.begin() + j + 1);
+                    break;
+                }
+            }
         }
         plys++;
     }
-    // display new move, if it's not pass, add it to past moves
-    if (best_move != nullptr){
-        fprintf(stderr, "%s's move: %d %d\n",
-                print_side(side), best_move->getX(), best_move->getY());
-    } else {
-        fprintf(stderr, "%s has to pass!\n",
-                print_side(side));
-    }
-
-    //------------- update board with chosen move! ----------------//
-    board->doMove(best_move, side);
-    fprintf(stderr, "new  score:  %s: %d to %s: %d\n-----------------------------------\n",
-            print_side(side), board->count(side), print_side(opp_side), board->count(opp_side));
     return best_move;
 }
 
@@ -163,12 +266,14 @@ std::vector<Move> Player::valid_moves(Board *board, Side side, bool eff) {
  *
  *  @arguments:
  *  board state, side of player to make move, vector of valid moves
- *  iteration level (ply) (not implemented)
+ *  iteration level (ply); the multi_pv best moves with their exact scores
+ *  and variations are left in ranked, best first
  *
  */
-Move *Player::choose_move(Board *board, Side side, std::vector<Move> valid_moves, std::list<Move>& ordered_moves, int plys, time_t end_turn, bool& timeout)
+Move *Player::choose_move(Board *board, Side side, std::vector<Move> valid_moves, std::list<Move>& ordered_moves, int plys, std::vector<PVLine> *ranked)
 {
-    time_t now;
+    std::vector<PVLine> top;
+    if (ranked != nullptr) ranked->clear();
      // if the provided move vector is empty, we can't do anything
     if (valid_moves.size() < 1)
     {
@@ -177,7 +282,7 @@ Move *Player::choose_move(Board *board, Side side, std::vector<Move> valid_moves
 
     //if we're out of time, choose the left most move
     Move best_move = valid_moves[0];
-    if (timeout)
+    if (control.stopped())
     {
         Move *final_move = new Move(best_move.getX(), best_move.getY());
         return final_move;
@@ -185,12 +290,10 @@ Move *Player::choose_move(Board *board, Side side, std::vector<Move> valid_moves
 
     Side opp_side = this->opp(side);
     Move next_move(0,0);
-    // Move *opp_move;
-    // std::vector<Move> opp_moves;
-    int best_score = -100;
+    std::vector<Move> child_line;
+    int best_score = -INF;
     int next_score;
-    int a = -100;
-    int b = 100;
+    unsigned int keep = multi_pv > 0 ? multi_pv : 1;
 
     for (unsigned int i = 0; i < valid_moves.size(); i++)
     {
@@ -198,38 +301,65 @@ Move *Player::choose_move(Board *board, Side side, std::vector<Move> valid_moves
         Board *next_board = board->copy();
         next_move = valid_moves[i];
         next_board->doMove(&next_move, side);
-        if ((next_move.getX() == 0 && next_move.getY() == 0) ||
+        if (take_corners && keep == 1 &&
+            ((next_move.getX() == 0 && next_move.getY() == 0) ||
             (next_move.getX() == 0 && next_move.getY() == 0) ||
             (next_move.getX() == 0 && next_move.getY() == 0) ||
-            (next_move.getX() == 0 && next_move.getY() == 0))
+            (next_move.getX() == 0 && next_move.getY() == 0)))
             {
+                delete next_board;
+                if (ranked != nullptr)
+                {
+                    PVLine line = { 0, std::vector<Move>(1, next_move) };
+                    ranked->push_back(line);
+                }
                 Move *final_move = new Move(next_move.getX(), next_move.getY());
                 return final_move;
             }
-        next_score = -this->alphaBeta(next_board, opp_side, a, b, plys, end_turn, timeout);
-        if (difftime(end_turn, time(&now)) <= 0)
+
+        // only a score above the worst line we're keeping matters, so that
+        // is alpha; moves that fail low can't make the list and anything
+        // that gets above it comes back exact
+        int a = top.size() < keep ? -INF : top.back().score;
+        int y = -INF;
+        int z = -a;
+        next_score = -this->alphaBeta(next_board, opp_side, y, z, plys, &child_line);
+        delete next_board;
+        // an interrupted search's score means nothing
+        if (control.stopped())
         {
-            timeout = true;
             break;
         }
 
         // fprintf(stderr, "move: %d %d, a :%d, b: %d, score: %d\n",
-        //         next_move.getX(), next_move.getY(), a, b, next_score);
-
-        // decide if this option is better than any others
-        if (next_score >= best_score) {
-            best_move = next_move;
-            best_score = next_score;
-            if (plys == 2) ordered_moves.push_front(best_move);
+        //         next_move.getX(), next_move.getY(), a, INF, next_score);
+
+        // decide if this option is good enough to keep
+        if (next_score > a) {
+            PVLine line = { next_score, std::vector<Move>(1, next_move) };
+            line.pv.insert(line.pv.end(), child_line.begin(), child_line.end());
+            unsigned int j = 0;
+            while (j < top.size() && top[j].score >= next_score) j++;
+            top.insert(top.begin() + j, line);
+            if (top.size() > keep) top.pop_back();
+            if (plys == 2) ordered_moves.push_front(next_move);
         }
         else {
             if (plys == 2) ordered_moves.push_back(next_move);
         }
     }
+    if (!top.empty())
+    {
+        best_move = top[0].pv[0];
+        best_score = top[0].score;
+    }
+    if (ranked != nullptr) *ranked = top;
+
     // give back the move we chose!
-    fprintf(stderr, "chose move: %d %d with score %d\n",
+    if (verbose) LOG_DEBUG("chose move: %d %d with score %d\n",
             best_move.getX(), best_move.getY(), best_score );
     Move *final_move = new Move(best_move.getX(), best_move.getY());
+    final_move->score = best_score;
     return final_move;
 }
 
@@ -243,14 +373,17 @@ Move *Player::choose_move(Board *board, Side side, std::vector<Move> valid_moves
  */
 int Player::getScore(Board *board, Side side)
 {
-    int score, board_count, board_opp_count, diff_score;
+    int score, board_count, board_opp_count, diff_score = 0;
     int corner_score = 0, moves_score = 0, edge_score = 0, near_corner_score = 0;
     Side opp_side = opp(side);
 
     // piece parity checking
     board_count = board->count(side);
     board_opp_count = board->count(opp_side);
-    diff_score = (board_count - board_opp_count) / (board_count + board_opp_count);
+    if (board_count + board_opp_count != 0)
+    {
+        diff_score = (board_count - board_opp_count) / (board_count + board_opp_count);
+    }
     diff_score *= 100;
 
     // mobility checking
@@ -259,7 +392,7 @@ int Player::getScore(Board *board, Side side)
     int total = total_moves.size() + total_opp_moves.size();
     if (total != 0)
     {
-        moves_score = (total_moves.size() - total_opp_moves.size()) / total;
+        moves_score = ((int) total_moves.size() - (int) total_opp_moves.size()) / total;
     }
     moves_score *= 100;
 
@@ -320,25 +453,101 @@ int Player::getScore(Board *board, Side side)
     edge_score = 100 * edge_score / 16;
     corner_score = 100 * corner_score / 4;
     near_corner_score = 100 * near_corner_score / 24;
-    score = 0.1 * diff_score + 0.1 * moves_score + 0.4 * corner_score + 0.2 * edge_score + 0.2 * near_corner_score;
-    if (board_count + board_opp_count > 50)
+    score = weights.diff * diff_score + weights.moves * moves_score + weights.corner * corner_score
+          + weights.edge * edge_score + weights.near_corner * near_corner_score;
+    if (board_count + board_opp_count > weights.endgame_discs)
     {
-        score = 0.40 * diff_score + 0.30 * corner_score + 0.1 * edge_score + 0.20 * near_corner_score;
+        score = weights.end_diff * diff_score + weights.end_corner * corner_score
+              + weights.end_edge * edge_score + weights.end_near_corner * near_corner_score;
     }
     return score;
 }
 
-int Player::alphaBeta(Board *board, Side side, int& a, int& b, int plys, time_t end_turn, bool& timeout)
+/*
+ *  @brief reads "name value" lines from a config file into the tunable
+ *  parameters; blank lines and lines starting with # are skipped
+ *
+ *  @arguments:
+ *  path of the config file; returns false if it can't be opened
+ *
+ */
+bool Player::loadConfig(const char *path)
+{
+    FILE *file = fopen(path, "r");
+    if (file == nullptr)
+    {
+        return false;
+    }
+
+    char buf[256], key[64];
+    double value;
+    while (fgets(buf, sizeof(buf), file) != nullptr)
+    {
+        if (sscanf(buf, " %63s %lf", key, &value) != 2 || key[0] == '#') continue;
+
+        if (!strcmp(key, "eval_diff")) weights.diff = value;
+        else if (!strcmp(key, "eval_moves")) weights.moves = value;
+        else if (!strcmp(key, "eval_corner")) weights.corner = value;
+        else if (!strcmp(key, "eval_edge")) weights.edge = value;
+        else if (!strcmp(key, "eval_near_corner")) weights.near_corner = value;
+        else if (!strcmp(key, "eval_end_diff")) weights.end_diff = value;
+        else if (!strcmp(key, "eval_end_corner")) weights.end_corner = value;
+        else if (!strcmp(key, "eval_end_edge")) weights.end_edge = value;
+        else if (!strcmp(key, "eval_end_near_corner")) weights.end_near_corner = value;
+        else if (!strcmp(key, "eval_endgame_discs")) weights.endgame_discs = (int) value;
+        else if (!strcmp(key, "lmr_min_depth")) params.lmr_min_depth = (int) value;
+        else if (!strcmp(key, "lmr_full_moves")) params.lmr_full_moves = (int) value;
+        else if (!strcmp(key, "lmr_reduction")) params.lmr_reduction = (int) value;
+        else if (!strcmp(key, "ext_single_reply")) params.ext_single_reply = (int) value;
+        else if (!strcmp(key, "ext_corner")) params.ext_corner = (int) value;
+        else if (!strcmp(key, "ext_max")) params.ext_max = (int) value;
+        else if (!strcmp(key, "check_nodes")) control.check_nodes = value > 0 ? (int) value : 1;
+        else if (!strncmp(key, "mcts_", 5) && mcts == nullptr) continue;
+        else if (!strcmp(key, "mcts_threads")) mcts->threads = value > 0 ? (int) value : 1;
+        else if (!strcmp(key, "mcts_exploration")) mcts->exploration = value;
+        else if (!strcmp(key, "mcts_virtual_loss")) mcts->virtual_loss = (int) value;
+        else if (!strcmp(key, "mcts_playout_depth")) mcts->playout_depth = (int) value;
+        else if (!strcmp(key, "mcts_playout_greedy")) mcts->playout_greedy = value;
+        else if (verbose) fprintf(stderr, "unknown config key %s in %s\n", key, path);
+    }
+    fclose(file);
+
+    // stored scores came from the old weights
+    tt.clear();
+    return true;
+}
+
+int Player::alphaBeta(Board *board, Side side, int& a, int& b, int plys, std::vector<Move> *line)
 {
-    if (timeout)
+    // once stopped, every level returns straight away without touching its
+    // window or the table, and the caller throws the result out
+    if (control.poll())
     {
         return 0;
     }
-    time_t now;
-    if (difftime(end_turn, time(&now)) <= 0)
+    if (line != nullptr) line->clear();
+    nodes++;
+
+    // reuse what an earlier iteration or PV line found out about this position
+    unsigned long long key = board->hash(side);
+    int tt_move = -1;
+    TTEntry *entry = tt.probe(key);
+    if (entry != nullptr)
     {
-        timeout = true;
-        return 0;
+        tt_move = entry->move;
+        if (entry->depth >= plys)
+        {
+            if (entry->bound == BOUND_LOWER && entry->score >= b) return b;
+            if (entry->bound == BOUND_UPPER && entry->score <= a) return a;
+            if (entry->bound == BOUND_EXACT)
+            {
+                if (entry->score >= b) return b;
+                if (entry->score <= a) return a;
+                a = entry->score;
+                if (line != nullptr) pv_from_table(board, side, plys, line);
+                return a;
+            }
+        }
     }
 
     std::vector<Move> valid_moves = this->valid_moves(board, side, false);
@@ -348,28 +557,136 @@ int Player::alphaBeta(Board *board, Side side, int& a, int& b, int plys, time_t
         score = this->getScore(board, side);
         return score;
     }
+
+    // try the table's best move first
+    for (unsigned int i = 1; i < valid_moves.size(); i++)
+    {
+        if (valid_moves[i].getX() + 8 * valid_moves[i].getY() == tt_move)
+        {
+            Move first = valid_moves[i];
+            valid_moves.erase(valid_moves.begin() + i);
+            valid_moves.insert(valid_moves.begin(), first);
+            break;
+        }
+    }
+
     Side opp_side = opp(side);
     Move next_move(0,0);
+    std::vector<Move> child_line;
+    int alpha = a;
+    int best = -1;
+    // corners the opponent can already take, to spot moves that hand one over
+    int opp_corners = params.ext_corner > 0 ? corner_moves(board, opp_side) : 0;
     for (unsigned int i = 0; i < valid_moves.size(); i++)
     {
         Board *next_board = board->copy();
         next_move = valid_moves[i];
         next_board->doMove(&next_move, side);
-        int y = -b;
-        int z = -a;
-        score = -(this->alphaBeta(next_board, opp_side, y, z, plys - 1, end_turn, timeout));
+
+        // forced replies and corner fights get searched deeper
+        int ext = 0;
+        if (extensions < params.ext_max)
+        {
+            if (valid_moves.size() == 1)
+            {
+                ext = params.ext_single_reply;
+            }
+            if (params.ext_corner > ext &&
+                ((next_move.getX() % 7 == 0 && next_move.getY() % 7 == 0) ||
+                 corner_moves(next_board, opp_side) > opp_corners))
+            {
+                ext = params.ext_corner;
+            }
+        }
+
+        // late moves in the ordering are probably bad, so check that cheaply
+        // with a shallower null window search before spending full depth
+        int reduction = 0;
+        if (ext == 0 && plys >= params.lmr_min_depth && (int) i >= params.lmr_full_moves)
+        {
+            reduction = params.lmr_reduction;
+        }
+
+        if (ext > 0) extensions++;
+        if (reduction > 0)
+        {
+            int y = -a - 1;
+            int z = -a;
+            int depth = plys - 1 - reduction > 0 ? plys - 1 - reduction : 0;
+            score = -(this->alphaBeta(next_board, opp_side, y, z, depth));
+            if (score > a) reduction = 0;
+        }
+        if (reduction == 0 && !control.stopped())
+        {
+            int y = -b;
+            int z = -a;
+            score = -(this->alphaBeta(next_board, opp_side, y, z, plys - 1 + ext,
+                                      line != nullptr ? &child_line : nullptr));
+        }
+        if (ext > 0) extensions--;
+        delete next_board;
+        if (control.stopped())
+        {
+            return 0;
+        }
         if (score > a)
         {
             a = score;
+            best = next_move.getX() + 8 * next_move.getY();
+            if (line != nullptr)
+            {
+                line->assign(1, next_move);
+                line->insert(line->end(), child_line.begin(), child_line.end());
+            }
         }
         if (score >= b)
         {
+            tt.store(key, plys, b, BOUND_LOWER, next_move.getX() + 8 * next_move.getY());
             return b;
         }
     }
+    tt.store(key, plys, a, a > alpha ? BOUND_EXACT : BOUND_UPPER, best >= 0 ? best : tt_move);
     return a;
 }
 
+/*
+ *  @brief counts the corners side could play in right now
+ *
+ */
+int Player::corner_moves(Board *board, Side side)
+{
+    int count = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        Move corner(7 * (i % 2), 7 * (i / 2));
+        if (board->checkMove(&corner, side)) count++;
+    }
+    return count;
+}
+
+/*
+ *  @brief fills in a variation by following the best moves stored in the
+ *  transposition table, for when a search is cut short by a table hit
+ *
+ *  @arguments:
+ *  board state, side to move, how many plies to follow at most
+ *
+ */
+void Player::pv_from_table(Board *board, Side side, int plys, std::vector<Move> *line)
+{
+    Board next_board = *board;
+    for (int i = 0; i < plys; i++)
+    {
+        TTEntry *entry = tt.probe(next_board.hash(side));
+        if (entry == nullptr || entry->move < 0) break;
+        Move next_move(entry->move % 8, entry->move / 8);
+        if (!next_board.checkMove(&next_move, side)) break;
+        line->push_back(next_move);
+        next_board.doMove(&next_move, side);
+        side = opp(side);
+    }
+}
+
 
 // ------- drafting timing calls -----------------//
     // just interested in the timer, I don't think we have to worry about it this week
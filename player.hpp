@@ -6,28 +6,110 @@
 #include <list>
 #include "common.hpp"
 #include "board.hpp"
+#include "mcts.hpp"
+#include "tt.hpp"
+#include "control.hpp"
 
 using namespace std;
 
+// weights used by getScore; the defaults are our hand-tuned values and can be
+// overridden with Player::loadConfig
+struct EvalWeights {
+    // opening and midgame
+    double diff, moves, corner, edge, near_corner;
+    // once more than endgame_discs stones are on the board
+    double end_diff, end_corner, end_edge, end_near_corner;
+    int endgame_discs;
+
+    EvalWeights() :
+        diff(0.1), moves(0.1), corner(0.4), edge(0.2), near_corner(0.2),
+        end_diff(0.40), end_corner(0.30), end_edge(0.1), end_near_corner(0.20),
+        endgame_discs(50) {}
+};
+
+// depth adjustments inside alphaBeta, also loadable with Player::loadConfig
+struct SearchParams {
+    // moves after the first lmr_full_moves at nodes with at least
+    // lmr_min_depth plys left are searched lmr_reduction plys shallower
+    // first, and again at full depth if they beat alpha
+    int lmr_min_depth, lmr_full_moves, lmr_reduction;
+    // extra plys for a side with only one move, and for moves that take a
+    // corner or let the opponent take one
+    int ext_single_reply, ext_corner;
+    // most extended moves along any one line
+    int ext_max;
+
+    SearchParams() :
+        lmr_min_depth(3), lmr_full_moves(3), lmr_reduction(1),
+        ext_single_reply(1), ext_corner(1), ext_max(1) {}
+};
+
+// one ranked root move with its principal variation; pv[0] is the move
+struct PVLine {
+    int score;
+    std::vector<Move> pv;
+};
+
+// which engine picks the moves
+enum SearchMode {
+    ALPHA_BETA, MONTE_CARLO
+};
+
 class Player {
 
 public:
-    Player(Side color);
+    Player(Side color, SearchMode mode = ALPHA_BETA, bool verbose = true);
     ~Player();
 
     Board *board;
     Side side;
     Move *doMove(Move *opponentsMove, int msLeft);
 
+    // search driver shared by doMove and the library interface
+    SearchMode mode;
+    Move *search(Board *board, Side side, int max_plys, int ms);
+    // time limit and stop flag of the running search
+    SearchControl control;
+    void stop() { control.stop(); }
+    // principal variation of the last completed search iteration
+    std::vector<Move> pv;
+    // number of root moves to keep exact scores and variations for
+    unsigned int multi_pv;
+    // the multi_pv best root moves of the last completed iteration, best first
+    std::vector<PVLine> lines;
+    // deepest completed iteration of the last search
+    int search_depth;
+    // alphaBeta calls in the last search
+    long nodes;
+    // play the corner at once when it is legal, without searching; off for
+    // callers that report scores, since the shortcut has none
+    bool take_corners;
+
+    // -------------- monte carlo tree search -------------- //
+    // only allocated in MONTE_CARLO mode
+    MCTS *mcts;
+
     // -------------- optimizing valid move finder --------- //
     std::vector<Move> past_moves;
     std::vector<Move> adjacents;
     std::vector<Move> valid_moves(Board *board, Side side, bool eff);
 
     // -------------- optimizing move chooser -------------- //
-    Move *choose_move(Board *board, Side side, std::vector<Move> valid_moves, std::list<Move>& ordered_moves, int plys, time_t end_time, bool& timeout);
+    Move *choose_move(Board *board, Side side, std::vector<Move> valid_moves, std::list<Move>& ordered_moves, int plys, std::vector<PVLine> *ranked = nullptr);
     int getScore(Board *board, Side side);
-    int alphaBeta(Board *board, Side side, int& a, int& b, int plys, time_t end_time, bool& timeout);
+    int alphaBeta(Board *board, Side side, int& a, int& b, int plys, std::vector<Move> *line = nullptr);
+
+    // positions searched so far, shared across iterations, PV lines and moves
+    TranspositionTable tt;
+    void pv_from_table(Board *board, Side side, int plys, std::vector<Move> *line);
+    int corner_moves(Board *board, Side side);
+    // extended moves on the line alphaBeta is currently searching
+    int extensions;
+
+    // -------------- tunable parameters ------------------- //
+    EvalWeights weights;
+    SearchParams params;
+    bool loadConfig(const char *path);
 
     // returns a string describing the input side object
     const char * print_side(Side side){
@@ -44,6 +126,9 @@ public:
 
     // Flag to tell if the player is running within the test_minimax context
     bool minimaxTest;
+
+    // set to false to keep the search from printing its progress to stderr
+    bool verbose;
 };
 
 #endif
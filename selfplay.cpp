@@ -0,0 +1,89 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "common.hpp"
+#include "player.hpp"
+#include "board.hpp"
+
+// Plays two engine configurations against each other, alternating colors, and
+// reports the first one's results. Each player is "alphabeta" or "mcts",
+// optionally followed by ":file" to load a config file for it.
+static Player *make_player(const char *spec, Side side) {
+    std::string name(spec);
+    std::string config;
+    size_t colon = name.find(':');
+    if (colon != std::string::npos) {
+        config = name.substr(colon + 1);
+        name = name.substr(0, colon);
+    }
+
+    SearchMode mode = (name == "mcts") ? MONTE_CARLO : ALPHA_BETA;
+    Player *player = new Player(side, mode, false);
+    if (!config.empty() && !player->loadConfig(config.c_str())) {
+        fprintf(stderr, "can't read config %s\n", config.c_str());
+        exit(-1);
+    }
+    return player;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc != 5) {
+        fprintf(stderr, "usage: %s games seconds_per_move player1 player2\n", argv[0]);
+        exit(-1);
+    }
+    int games = atoi(argv[1]);
+    double seconds = atof(argv[2]);
+    int ms = (int) (seconds * 1000);
+
+    int wins = 0, losses = 0, draws = 0;
+    double playout_rate[2] = {0, 0};
+    long mcts_moves[2] = {0, 0};
+
+    for (int game = 0; game < games; game++) {
+        // player1 takes black in even games
+        Side first_side = (game % 2 == 0) ? BLACK : WHITE;
+        Player *players[2];
+        players[0] = make_player(argv[3], first_side);
+        players[1] = make_player(argv[4], first_side == BLACK ? WHITE : BLACK);
+
+        Board board;
+        Side to_move = BLACK;
+        while (!board.isDone()) {
+            int p = (players[0]->side == to_move) ? 0 : 1;
+            Move *move = players[p]->search(&board, to_move, 64, ms);
+            board.doMove(move, to_move);
+            delete move;
+
+            if (players[p]->mcts != nullptr) {
+                playout_rate[p] += players[p]->mcts->playouts_per_sec;
+                mcts_moves[p]++;
+            }
+            to_move = (to_move == BLACK) ? WHITE : BLACK;
+        }
+
+        int mine = board.count(first_side);
+        int theirs = board.count(first_side == BLACK ? WHITE : BLACK);
+        if (mine > theirs) wins++;
+        else if (mine < theirs) losses++;
+        else draws++;
+        printf("game %d: %s as %s %d - %d\n", game + 1, argv[3],
+               players[0]->print_side(first_side), mine, theirs);
+        fflush(stdout);
+
+        delete players[0]->board;
+        delete players[0];
+        delete players[1]->board;
+        delete players[1];
+    }
+
+    printf("%s vs %s at %gs/move: %d wins, %d losses, %d draws (%.1f%%)\n",
+           argv[3], argv[4], seconds, wins, losses, draws,
+           games > 0 ? 100.0 * (wins + 0.5 * draws) / games : 0.0);
+    for (int p = 0; p < 2; p++) {
+        if (mcts_moves[p] > 0) {
+            printf("%s: %.0f playouts/s\n", argv[3 + p], playout_rate[p] / mcts_moves[p]);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,250 @@
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "sharknado.h"
+#include "player.hpp"
+
+// the batch being scored; worker i takes chunk i and the caller takes chunk 0
+struct BatchJob {
+    const uint64_t *black;
+    const uint64_t *white;
+    const int *sides;
+    int *scores;
+    size_t n, chunk;
+};
+
+struct sharknado_engine {
+    Player *player;
+    Side side;
+    int threads;
+
+    // batch evaluation workers, started on the first batch big enough to
+    // split and kept until the handle is destroyed
+    std::vector<std::thread> workers;
+    std::mutex lock;
+    std::condition_variable work_ready, work_done;
+    BatchJob job;
+    unsigned long generation;
+    size_t pending;
+    bool shutdown;
+};
+
+// deepest ply doMove searches to; used when the limit doesn't give one
+static const int DEFAULT_MAX_DEPTH = 11;
+
+// the tree search ignores max_depth, so it needs a budget of its own
+static const int DEFAULT_MCTS_MS = 1000;
+
+// fewest positions worth handing to another thread
+static const size_t MIN_CHUNK = 64;
+
+static int square(Move *m) {
+    return m == nullptr ? SHARKNADO_PASS : m->getX() + 8 * m->getY();
+}
+
+// the masks and side the engine can score: some stones, none on both colors
+static bool valid_position(uint64_t black, uint64_t white, int side) {
+    if ((black | white) == 0 || (black & white) != 0) return false;
+    return side == SHARKNADO_WHITE || side == SHARKNADO_BLACK;
+}
+
+static void copy_line(const std::vector<Move>& pv, sharknado_result *result) {
+    result->pv_length = 0;
+    for (unsigned int i = 0; i < pv.size() && i < SHARKNADO_MAX_PV; i++) {
+        Move m = pv[i];
+        result->pv[result->pv_length++] = square(&m);
+    }
+}
+
+/*
+ * Runs the search for the side to move under the given limit.
+ */
+static Move *run_search(sharknado_engine *engine, const sharknado_limit *limit) {
+    Player *player = engine->player;
+    int max_depth = limit->max_depth > 0 ? limit->max_depth : DEFAULT_MAX_DEPTH;
+    int ms = limit->time_ms;
+    if (ms <= 0 && player->mode == MONTE_CARLO) ms = DEFAULT_MCTS_MS;
+    return player->search(player->board, engine->side, max_depth, ms);
+}
+
+/*
+ * Scores positions [begin, end) of a batch into the caller's buffer.
+ */
+static void evaluate_range(Player *player, const uint64_t *black,
+                           const uint64_t *white, const int *sides,
+                           size_t begin, size_t end, int *scores) {
+    Board board;
+    for (size_t i = begin; i < end; i++) {
+        board.setBitboards(black[i], white[i]);
+        scores[i] = player->getScore(&board, sides[i] == SHARKNADO_BLACK ? BLACK : WHITE);
+    }
+}
+
+/*
+ * Waits for batches and scores this worker's chunk of each one.
+ */
+static void batch_worker(sharknado_engine *engine, size_t index, unsigned long seen) {
+    std::unique_lock<std::mutex> guard(engine->lock);
+    while (true) {
+        engine->work_ready.wait(guard, [&] { return engine->shutdown || engine->generation != seen; });
+        if (engine->shutdown) return;
+        seen = engine->generation;
+
+        BatchJob job = engine->job;
+        size_t begin = index * job.chunk;
+        if (begin >= job.n) continue;
+        size_t end = begin + job.chunk < job.n ? begin + job.chunk : job.n;
+        guard.unlock();
+        evaluate_range(engine->player, job.black, job.white, job.sides, begin, end, job.scores);
+        guard.lock();
+        if (--engine->pending == 0) engine->work_done.notify_one();
+    }
+}
+
+extern "C" {
+
+int sharknado_abi_version(void) {
+    return SHARKNADO_ABI_VERSION;
+}
+
+void sharknado_default_config(sharknado_config *cfg) {
+    cfg->mode = SHARKNADO_ALPHA_BETA;
+    cfg->threads = 1;
+    cfg->hash_mb = 0;
+    cfg->eval_file = nullptr;
+}
+
+sharknado_engine *sharknado_create(const sharknado_config *cfg) {
+    sharknado_config defaults;
+    sharknado_default_config(&defaults);
+    if (cfg == nullptr) cfg = &defaults;
+
+    SearchMode mode = cfg->mode == SHARKNADO_MONTE_CARLO ? MONTE_CARLO : ALPHA_BETA;
+    Player *player = new Player(BLACK, mode, false);
+    player->take_corners = false;
+    if (cfg->hash_mb > 0) player->tt.resize(cfg->hash_mb);
+    if (player->mcts != nullptr) player->mcts->threads = cfg->threads > 0 ? cfg->threads : 1;
+    if (cfg->eval_file != nullptr && !player->loadConfig(cfg->eval_file)) {
+        delete player->board;
+        delete player;
+        return nullptr;
+    }
+
+    sharknado_engine *engine = new sharknado_engine;
+    engine->player = player;
+    engine->side = BLACK;
+    engine->threads = cfg->threads > 0 ? cfg->threads : 1;
+    engine->generation = 0;
+    engine->pending = 0;
+    engine->shutdown = false;
+    return engine;
+}
+
+void sharknado_destroy(sharknado_engine *engine) {
+    if (engine == nullptr) return;
+    {
+        std::lock_guard<std::mutex> guard(engine->lock);
+        engine->shutdown = true;
+    }
+    engine->work_ready.notify_all();
+    for (unsigned int i = 0; i < engine->workers.size(); i++) {
+        engine->workers[i].join();
+    }
+    delete engine->player->board;
+    delete engine->player;
+    delete engine;
+}
+
+int sharknado_set_position(sharknado_engine *engine, uint64_t black,
+                           uint64_t white, int side) {
+    if (engine == nullptr || !valid_position(black, white, side)) return -1;
+
+    engine->player->board->setBitboards(black, white);
+    engine->side = side == SHARKNADO_BLACK ? BLACK : WHITE;
+    engine->player->side = engine->side;
+    return 0;
+}
+
+int sharknado_search(sharknado_engine *engine, const sharknado_limit *limit,
+                     sharknado_result *result) {
+    if (engine == nullptr || limit == nullptr || result == nullptr) return -1;
+
+    Player *player = engine->player;
+    player->multi_pv = 1;
+    Move *best_move = run_search(engine, limit);
+
+    result->move = square(best_move);
+    result->score = best_move != nullptr ? best_move->score : player->getScore(player->board, engine->side);
+    result->depth = player->search_depth;
+    copy_line(player->pv, result);
+    delete best_move;
+    return 0;
+}
+
+int sharknado_analyze(sharknado_engine *engine, const sharknado_limit *limit,
+                      int k, sharknado_result *results) {
+    if (engine == nullptr || limit == nullptr || results == nullptr || k < 1) return -1;
+
+    Player *player = engine->player;
+    player->multi_pv = k;
+    delete run_search(engine, limit);
+    player->multi_pv = 1;
+
+    int count = 0;
+    for (unsigned int i = 0; i < player->lines.size() && count < k; i++) {
+        if (player->lines[i].pv.empty()) continue;
+        sharknado_result *result = &results[count++];
+        result->move = square(&player->lines[i].pv[0]);
+        result->score = player->lines[i].score;
+        result->depth = player->search_depth;
+        copy_line(player->lines[i].pv, result);
+    }
+    return count;
+}
+
+void sharknado_stop(sharknado_engine *engine) {
+    if (engine == nullptr) return;
+    engine->player->stop();
+}
+
+int sharknado_evaluate_batch(sharknado_engine *engine, const uint64_t *black,
+                             const uint64_t *white, const int *sides,
+                             size_t n, int *scores) {
+    if (engine == nullptr) return -1;
+    if (n == 0) return 0;
+    if (black == nullptr || white == nullptr || sides == nullptr || scores == nullptr) return -1;
+    for (size_t i = 0; i < n; i++) {
+        if (!valid_position(black[i], white[i], sides[i])) return -1;
+    }
+
+    // split the batch into one contiguous chunk per thread, and don't bother
+    // waking workers for batches too small to be worth it
+    size_t parts = n / MIN_CHUNK;
+    if (parts > (size_t) engine->threads) parts = engine->threads;
+    if (parts <= 1) {
+        evaluate_range(engine->player, black, white, sides, 0, n, scores);
+        return 0;
+    }
+    size_t chunk = (n + parts - 1) / parts;
+
+    std::unique_lock<std::mutex> guard(engine->lock);
+    while (engine->workers.size() < parts - 1) {
+        engine->workers.push_back(std::thread(batch_worker, engine, engine->workers.size() + 1,
+                                              engine->generation));
+    }
+    BatchJob job = { black, white, sides, scores, n, chunk };
+    engine->job = job;
+    engine->pending = (n - 1) / chunk;
+    engine->generation++;
+    guard.unlock();
+    engine->work_ready.notify_all();
+
+    evaluate_range(engine->player, black, white, sides, 0, chunk, scores);
+
+    guard.lock();
+    engine->work_done.wait(guard, [&] { return engine->pending == 0; });
+    return 0;
+}
+
+}
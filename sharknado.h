@@ -0,0 +1,141 @@
+#ifndef __SHARKNADO_H__
+#define __SHARKNADO_H__
+
+/*
+ * C interface to the Sharknado engine, built as libsharknado.so. Lets a
+ * service run searches in-process instead of driving the sharknado binary
+ * over the wrapper's stdin protocol.
+ *
+ * Squares are numbered x + 8*y, matching Board. A position is a pair of
+ * 64-bit masks with bit x + 8*y set where that color has a stone. Moves are
+ * reported as square numbers, with -1 meaning pass.
+ *
+ * Each handle owns its own engine state, so different handles can be used
+ * from different threads at once. A single handle must not be used by two
+ * threads at the same time, except for sharknado_stop.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* the library is built with hidden visibility; only these are exported */
+#if defined(__GNUC__)
+#define SHARKNADO_API __attribute__((visibility("default")))
+#else
+#define SHARKNADO_API
+#endif
+
+/*
+ * Bumped whenever a struct below changes layout or a function changes its
+ * meaning. Compare with sharknado_abi_version() before using a library
+ * loaded at run time.
+ */
+#define SHARKNADO_ABI_VERSION 1
+
+#define SHARKNADO_WHITE 0
+#define SHARKNADO_BLACK 1
+
+#define SHARKNADO_ALPHA_BETA 0
+#define SHARKNADO_MONTE_CARLO 1
+
+#define SHARKNADO_PASS -1
+#define SHARKNADO_MAX_PV 64
+
+typedef struct sharknado_engine sharknado_engine;
+
+typedef struct {
+    /* SHARKNADO_ALPHA_BETA or SHARKNADO_MONTE_CARLO */
+    int mode;
+    /* worker threads used by sharknado_evaluate_batch and the tree search */
+    int threads;
+    /* transposition table size in megabytes, or 0 for the default */
+    int hash_mb;
+    /* optional config file of "name value" lines, or NULL for the defaults */
+    const char *eval_file;
+} sharknado_config;
+
+typedef struct {
+    /* deepest ply to search to, or 0 for the engine default; ignored by the
+     * tree search */
+    int max_depth;
+    /* time budget in milliseconds; 0 stops alpha-beta only at max_depth or
+     * on sharknado_stop, and gives the tree search a default of one second */
+    int time_ms;
+} sharknado_limit;
+
+typedef struct {
+    int move;
+    /* alpha-beta: the evaluation for the side to move; tree search: the
+     * move's win rate for the side to move scaled to -100..100, with 0 even */
+    int score;
+    int depth;
+    int pv_length;
+    int pv[SHARKNADO_MAX_PV];
+} sharknado_result;
+
+/* Returns the SHARKNADO_ABI_VERSION the library was built with. */
+SHARKNADO_API int sharknado_abi_version(void);
+
+/* Fills cfg with the default configuration. */
+SHARKNADO_API void sharknado_default_config(sharknado_config *cfg);
+
+/*
+ * Creates an engine set to the standard starting position with black to
+ * move. cfg may be NULL for the defaults. Returns NULL if the eval file
+ * can't be read.
+ */
+SHARKNADO_API sharknado_engine *sharknado_create(const sharknado_config *cfg);
+
+SHARKNADO_API void sharknado_destroy(sharknado_engine *engine);
+
+/*
+ * Returns 0 on success, -1 if the masks are both empty or overlap, or side is
+ * invalid.
+ */
+SHARKNADO_API int sharknado_set_position(sharknado_engine *engine, uint64_t black,
+                                         uint64_t white, int side);
+
+/*
+ * Searches the current position for the side to move. Returns 0 on success
+ * and -1 on bad arguments.
+ */
+SHARKNADO_API int sharknado_search(sharknado_engine *engine, const sharknado_limit *limit,
+                                   sharknado_result *result);
+
+/*
+ * Searches the current position keeping the k best root moves, each with an
+ * exact score and its own principal variation, and writes them best first
+ * to results[0..k). Returns the number of lines written, which is less than
+ * k when there are fewer legal moves, or -1 on bad arguments. The tree
+ * search only reports its best line.
+ */
+SHARKNADO_API int sharknado_analyze(sharknado_engine *engine, const sharknado_limit *limit,
+                                    int k, sharknado_result *results);
+
+/*
+ * Makes a search running on this handle in another thread return as soon as
+ * it can, with the result of its last completed iteration, or the first
+ * legal move if none completed. A stop sent while no search is running has no
+ * effect.
+ */
+SHARKNADO_API void sharknado_stop(sharknado_engine *engine);
+
+/*
+ * Scores n positions with the static evaluation, from the point of view of
+ * sides[i], writing scores[i]. Reads straight from the caller's arrays.
+ * Returns 0 on success and -1 on bad arguments, including any position that
+ * sharknado_set_position would reject, in which case no scores are written.
+ */
+SHARKNADO_API int sharknado_evaluate_batch(sharknado_engine *engine, const uint64_t *black,
+                                           const uint64_t *white, const int *sides,
+                                           size_t n, int *scores);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
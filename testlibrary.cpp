@@ -0,0 +1,129 @@
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "sharknado.h"
+
+// Drives libsharknado.so through its C interface only: positions the engine
+// must reject, search and analysis results, batch evaluation and stop.
+// Prints one line per check and exits non-zero if any of them failed.
+static int failures = 0;
+
+static void check(bool ok, const char *what) {
+    std::cout << (ok ? "Correct: " : "Wrong: ") << what << std::endl;
+    if (!ok) failures++;
+}
+
+// the standard starting position and black's four legal replies to it
+static const uint64_t START_BLACK = (1ULL << 28) | (1ULL << 35);
+static const uint64_t START_WHITE = (1ULL << 27) | (1ULL << 36);
+
+static bool opening_move(int move) {
+    return move == 19 || move == 26 || move == 37 || move == 44;
+}
+
+static long elapsed_ms(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char *argv[]) {
+    check(sharknado_abi_version() == SHARKNADO_ABI_VERSION, "library and header agree on the ABI version");
+
+    sharknado_config cfg;
+    sharknado_default_config(&cfg);
+    cfg.eval_file = "no/such/file.cfg";
+    check(sharknado_create(&cfg) == nullptr, "create fails on a missing eval file");
+
+    sharknado_engine *engine = sharknado_create(nullptr);
+    sharknado_limit limit = { 6, 0 };
+    sharknado_result result, lines[4];
+
+    // positions the engine can't score
+    check(sharknado_set_position(engine, 0, 0, SHARKNADO_BLACK) == -1, "set_position rejects an empty board");
+    check(sharknado_set_position(engine, 1, 1, SHARKNADO_BLACK) == -1, "set_position rejects overlapping masks");
+    check(sharknado_set_position(engine, START_BLACK, START_WHITE, 2) == -1, "set_position rejects a bad side");
+
+    uint64_t empty = 0, one = 1;
+    int side = SHARKNADO_BLACK, bad_side = 5, score = 0;
+    check(sharknado_evaluate_batch(engine, &empty, &empty, &side, 1, &score) == -1, "evaluate_batch rejects an empty board");
+    check(sharknado_evaluate_batch(engine, &one, &one, &side, 1, &score) == -1, "evaluate_batch rejects overlapping masks");
+    check(sharknado_evaluate_batch(engine, &one, &empty, &bad_side, 1, &score) == -1, "evaluate_batch rejects a bad side");
+
+    // searching the opening
+    check(sharknado_set_position(engine, START_BLACK, START_WHITE, SHARKNADO_BLACK) == 0, "set_position takes the opening");
+    sharknado_search(engine, &limit, &result);
+    check(opening_move(result.move) && result.depth == 6 && result.pv_length > 0 && result.pv[0] == result.move,
+          "search finds a legal opening move with its line");
+
+    int count = sharknado_analyze(engine, &limit, 4, lines);
+    bool ranked = count == 4;
+    for (int i = 0; i < count; i++) {
+        ranked = ranked && opening_move(lines[i].move) && lines[i].pv[0] == lines[i].move;
+        for (int j = 0; j < i; j++) ranked = ranked && lines[j].move != lines[i].move && lines[j].score >= lines[i].score;
+    }
+    check(ranked, "analyze ranks all four opening moves best first");
+
+    // black can take a1 here: the reported line has to come from a search
+    // rather than from the corner shortcut
+    uint64_t corner_black = START_BLACK | (1ULL << 2), corner_white = START_WHITE | (1ULL << 1);
+    sharknado_set_position(engine, corner_black, corner_white, SHARKNADO_BLACK);
+    sharknado_search(engine, &limit, &result);
+    check(result.move == 0 && result.depth == 6 && result.pv_length > 1, "search really searches a legal corner");
+    count = sharknado_analyze(engine, &limit, 2, lines);
+    check(count == 2 && lines[0].move == 0 && lines[0].score == result.score,
+          "analyze gives the corner the same score as search");
+
+    // batch evaluation across threads matches the single-threaded result
+    cfg.eval_file = nullptr;
+    cfg.threads = 4;
+    sharknado_engine *batch = sharknado_create(&cfg);
+    size_t n = 1000;
+    std::vector<uint64_t> black(n), white(n);
+    std::vector<int> sides(n), scores(n), expected(n);
+    for (size_t i = 0; i < n; i++) {
+        black[i] = START_BLACK | ((i * 0x9e3779b97f4a7c15ULL) & ~START_WHITE);
+        white[i] = START_WHITE | ((i * 0xc2b2ae3d27d4eb4fULL) & ~black[i]);
+        sides[i] = i % 2;
+    }
+    check(sharknado_evaluate_batch(batch, &black[0], &white[0], &sides[0], n, &scores[0]) == 0 &&
+          sharknado_evaluate_batch(engine, &black[0], &white[0], &sides[0], n, &expected[0]) == 0 &&
+          scores == expected, "evaluate_batch gives the same scores on four threads as on one");
+    sharknado_destroy(batch);
+
+    // stop from another thread, and a stop that comes in too late
+    limit.max_depth = 60;
+    sharknado_set_position(engine, START_BLACK, START_WHITE, SHARKNADO_BLACK);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::thread stopper([engine] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        sharknado_stop(engine);
+    });
+    sharknado_search(engine, &limit, &result);
+    stopper.join();
+    check(elapsed_ms(start) < 2000 && opening_move(result.move), "stop ends a search without a time limit");
+
+    sharknado_stop(engine);
+    limit.max_depth = 5;
+    sharknado_search(engine, &limit, &result);
+    check(result.depth == 5, "a stop sent between searches doesn't cut the next one short");
+    sharknado_destroy(engine);
+
+    // tree search: a zeroed limit still returns, and a budget too short for
+    // any playout still gives a legal move with a line
+    cfg.mode = SHARKNADO_MONTE_CARLO;
+    cfg.threads = 2;
+    engine = sharknado_create(&cfg);
+    sharknado_limit zero = { 0, 0 };
+    start = std::chrono::steady_clock::now();
+    sharknado_search(engine, &zero, &result);
+    check(elapsed_ms(start) < 5000 && opening_move(result.move), "tree search with a zeroed limit returns");
+
+    sharknado_limit quick = { 0, 1 };
+    count = sharknado_analyze(engine, &quick, 2, lines);
+    check(count == 1 && opening_move(lines[0].move) && lines[0].pv_length > 0 && lines[0].pv[0] == lines[0].move,
+          "tree search analyze returns a legal line on a tiny budget");
+    sharknado_destroy(engine);
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,48 @@
+#include <cstring>
+#include "tt.hpp"
+
+TranspositionTable::TranspositionTable(size_t mb) {
+    table = nullptr;
+    size = 0;
+    resize(mb);
+}
+
+TranspositionTable::~TranspositionTable() {
+    delete[] table;
+}
+
+/*
+ * Reallocates the table to the largest power of two entries that fits in the
+ * given number of megabytes (at least one entry) and empties it.
+ */
+void TranspositionTable::resize(size_t mb) {
+    size_t entries = (mb << 20) / sizeof(TTEntry);
+    size = 1;
+    while (size * 2 <= entries) size *= 2;
+
+    delete[] table;
+    table = new TTEntry[size];
+    clear();
+}
+
+void TranspositionTable::clear() {
+    memset(table, 0, size * sizeof(TTEntry));
+}
+
+/*
+ * Returns the entry stored for key, or nullptr if there isn't one.
+ */
+TTEntry *TranspositionTable::probe(unsigned long long key) {
+    TTEntry *entry = &table[key & (size - 1)];
+    if (entry->key != key || entry->depth == 0) return nullptr;
+    return entry;
+}
+
+void TranspositionTable::store(unsigned long long key, int depth, int score, Bound bound, int move) {
+    TTEntry *entry = &table[key & (size - 1)];
+    entry->key = key;
+    entry->score = score;
+    entry->depth = depth;
+    entry->move = move;
+    entry->bound = bound;
+}
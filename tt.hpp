@@ -0,0 +1,38 @@
+#ifndef __TT_H__
+#define __TT_H__
+
+#include <cstddef>
+
+// how a stored score relates to the true value of the position
+enum Bound {
+    BOUND_EXACT, BOUND_LOWER, BOUND_UPPER
+};
+
+struct TTEntry {
+    unsigned long long key;
+    short score;
+    signed char depth;
+    // square x + 8*y of the best move found, -1 if none
+    signed char move;
+    unsigned char bound;
+};
+
+// fixed-size transposition table, always replacing on collision
+class TranspositionTable {
+
+public:
+    TranspositionTable(size_t mb);
+    ~TranspositionTable();
+
+    void resize(size_t mb);
+    void clear();
+    TTEntry *probe(unsigned long long key);
+    void store(unsigned long long key, int depth, int score, Bound bound, int move);
+
+private:
+    TTEntry *table;
+    // number of entries, a power of two
+    size_t size;
+};
+
+#endif
@@ -6,14 +6,15 @@ using namespace std;
 
 int main(int argc, char *argv[]) {
     // Read in side the player is on.
-    if (argc != 2)  {
-        cerr << "usage: " << argv[0] << " side" << endl;
+    if (argc != 2 && argc != 3)  {
+        cerr << "usage: " << argv[0] << " side [alphabeta|mcts]" << endl;
         exit(-1);
     }
     Side side = (!strcmp(argv[1], "Black")) ? BLACK : WHITE;
+    SearchMode mode = (argc == 3 && !strcmp(argv[2], "mcts")) ? MONTE_CARLO : ALPHA_BETA;
 
     // Initialize player.
-    Player *player = new Player(side);
+    Player *player = new Player(side, mode);
 
     // Tell java wrapper that we are done initializing.
     cout << "Init done" << endl;
@@ -36,7 +37,6 @@ int main(int argc, char *argv[]) {
             cout << "-1 -1" << endl;
         }
         cout.flush();
-        cerr.flush();
 
         // Delete move objects.
         if (opponentsMove != nullptr) delete opponentsMove;